@@ -45,9 +45,11 @@ leaf nodes assume the child nodes as nullptr.
 
 #include <cstdint>
 #include <iostream>
+
+#include "MemoryStats.h"
 using namespace std;
 
-struct Node {
+struct Node : Tracked<Node> {
 	int data;
 	Node* leftChildXORparent = nullptr;
 	Node* rightChildXORparent = nullptr;
@@ -93,5 +95,9 @@ int main() {
 	six->rightChildXORparent = XOR(two, nullptr);
 
 	inorder(root);
+	Node::memoryStats().print("XOR tree", Node::memoryStats().liveAllocations());
+
+	for (Node* node : {root, one, two, three, four, five, six})
+		delete node;
 	return 0;
 }
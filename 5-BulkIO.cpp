@@ -0,0 +1,153 @@
+/*
+Command line tool to stream data in and out of the containers in bulk,
+using the compact binary record format described in BinaryIO.h (records go through stdin/stdout).
+
+	5-BulkIO encode keys|pairs	< text > records	whitespace separated integers to records
+	5-BulkIO decode				< records > text	records to text, one record per line
+	5-BulkIO skiplist			< records > records	ingest into a SkipList, export (key, value) pairs
+	5-BulkIO tbt				< records > records	ingest into a threaded BST, export keys
+	5-BulkIO xorlist			< records > records	ingest into a XOR list, export keys
+
+The skip list and the threaded BST are built with bulkLoad and export in increasing key order
+(duplicate keys collapse, for the skip list the last value wins), the XOR list keeps the input order.
+The memory used by the container is reported on stderr.
+
+build: g++ -std=c++17 -O2 -pthread 5-BulkIO.cpp -o bulkio
+*/
+
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BinaryIO.h"
+#include "SkipList.h"
+#include "ThreadedBST.h"
+#include "XORList.h"
+
+using namespace std;
+
+// Text to records, the text is parsed with cin as it is only a convenience for preparing inputs
+void encode(RecordKind kind) {
+	ios::sync_with_stdio(false);
+	RecordWriter out(stdout, kind);
+	int key, value;
+	while (cin >> key) {
+		if (kind == KEYS) {
+			out.write(key);
+		} else {
+			if (!(cin >> value))
+				throw runtime_error(cin.eof() ? "odd number of integers for pairs" : "invalid integer in input");
+			out.write(key, value);
+		}
+	}
+	if (!cin.eof())
+		throw runtime_error("invalid integer in input");
+	out.close();
+}
+
+// Records to text, formatted with to_chars into a large buffer instead of one cout << ... << endl per record
+void decode() {
+	RecordReader in(stdin);
+	vector<char> buffer(IO_CHUNK);
+	char *begin = buffer.data();
+	char *end = buffer.data() + buffer.size();
+	char *pos = begin;
+	int key, value;
+	while (in.read(key, value)) {
+		if (end - pos < 32) {  // room for two ints, a space and a newline
+			if (fwrite(begin, 1, pos - begin, stdout) != size_t(pos - begin))
+				throw runtime_error("failed to write text");
+			pos = begin;
+		}
+		pos = to_chars(pos, end, key).ptr;
+		if (in.getKind() == PAIRS) {
+			*pos++ = ' ';
+			pos = to_chars(pos, end, value).ptr;
+		}
+		*pos++ = '\n';
+	}
+	if (fwrite(begin, 1, pos - begin, stdout) != size_t(pos - begin) || fflush(stdout) != 0)
+		throw runtime_error("failed to write text");
+}
+
+void roundTripSkipList() {
+	RecordReader in(stdin);
+	vector<pair<int, int>> items;
+	int key, value;
+	while (in.read(key, value))
+		items.push_back(make_pair(key, value));
+
+	skiplist::SkipList list;
+	list.bulkLoad(move(items));
+
+	RecordWriter out(stdout, PAIRS);
+	list.forEach([&out](int key, int value) { out.write(key, value); });
+	out.close();
+	list.memoryStats().print("skiplist", list.getSize(), cerr);
+}
+
+void roundTripThreadedBST() {
+	RecordReader in(stdin);
+	vector<int> keys;
+	int key, value;
+	while (in.read(key, value))
+		keys.push_back(key);
+
+	tbt::Node tree;
+	tbt::Node *root = tree.bulkLoad(NULL, move(keys));
+
+	RecordWriter out(stdout, KEYS);
+	tree.visitInorder(root, [&out](int info) { out.write(info); });
+	out.close();
+	tbt::Node::memoryStats().print("tbt", root == NULL ? 0 : root->size, cerr);
+	tree.deleteTree(root);
+}
+
+void roundTripXORList() {
+	RecordReader in(stdin);
+	xorlist::Node *head = NULL;
+	xorlist::Node *tail = NULL;	 // the first node inserted stays at the far end of the list
+	int key, value;
+	while (in.read(key, value)) {
+		xorlist::insertFirst(&head, key);
+		if (tail == NULL)
+			tail = head;
+	}
+
+	// insertFirst reverses the input, so walking from the tail gives it back in input order
+	RecordWriter out(stdout, KEYS);
+	xorlist::forEach(tail, [&out](int data) { out.write(data); });
+	out.close();
+	xorlist::Node::memoryStats().print("xorlist", xorlist::Node::memoryStats().liveAllocations(), cerr);
+	xorlist::freeList(&head);
+}
+
+int main(int argc, char **argv) {
+	string command = argc > 1 ? argv[1] : "";
+	try {
+		if (command == "encode" && argc > 2 && string(argv[2]) == "keys")
+			encode(KEYS);
+		else if (command == "encode" && argc > 2 && string(argv[2]) == "pairs")
+			encode(PAIRS);
+		else if (command == "decode")
+			decode();
+		else if (command == "skiplist")
+			roundTripSkipList();
+		else if (command == "tbt")
+			roundTripThreadedBST();
+		else if (command == "xorlist")
+			roundTripXORList();
+		else {
+			cerr << "usage: " << argv[0] << " encode keys|pairs | decode | skiplist | tbt | xorlist  (stdin to stdout)" << endl;
+			return 2;
+		}
+	} catch (const exception &e) {
+		cerr << argv[0] << ": " << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,156 @@
+/*
+Compact binary record format used to move data in and out of the containers in bulk.
+
+	header:		"EDSA"		4 bytes magic
+				version		1 byte, currently 1
+				kind		1 byte, 1 = keys only, 2 = (key, value) pairs
+				reserved	2 bytes, 0
+	records:	key			4 bytes, little endian two's complement int
+				value		4 bytes, little endian two's complement int, only for pairs
+
+Records simply follow the header until the end of the file, so a file can be written in a
+single pass without knowing the number of records up front (e.g. when writing to a pipe).
+Both ends move data in 1 MiB chunks with fread/fwrite, a record is never formatted or flushed on its own.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+enum RecordKind : uint8_t {
+	KEYS = 1,
+	PAIRS = 2
+};
+
+const size_t IO_CHUNK = 1 << 20;
+const char RECORD_MAGIC[4] = {'E', 'D', 'S', 'A'};
+const uint8_t RECORD_VERSION = 1;
+
+// Encoded with shifts so the byte order is right on every host, compilers turn it into a plain store on little endian ones
+inline void storeLE(unsigned char *out, int v) {
+	uint32_t u = static_cast<uint32_t>(v);
+	out[0] = u;
+	out[1] = u >> 8;
+	out[2] = u >> 16;
+	out[3] = u >> 24;
+}
+
+inline int loadLE(const unsigned char *in) {
+	return static_cast<int>(uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16 | uint32_t(in[3]) << 24);
+}
+
+class RecordWriter {
+	FILE *file;
+	RecordKind kind;
+	std::vector<unsigned char> buffer;
+	size_t used;
+
+	void flush() {
+		if (used > 0 && fwrite(buffer.data(), 1, used, file) != used)
+			throw std::runtime_error("failed to write records");
+		used = 0;
+	}
+
+	void reserve(size_t bytes) {
+		if (used + bytes > buffer.size())
+			flush();
+	}
+
+public:
+	RecordWriter(FILE *file, RecordKind kind) : file(file), kind(kind), buffer(IO_CHUNK), used(0) {
+		memcpy(buffer.data(), RECORD_MAGIC, 4);
+		buffer[4] = RECORD_VERSION;
+		buffer[5] = kind;
+		buffer[6] = 0;
+		buffer[7] = 0;
+		used = 8;
+	}
+
+	RecordWriter(const RecordWriter &) = delete;
+	RecordWriter &operator=(const RecordWriter &) = delete;
+
+	// Flushes whatever is left, call close() instead to see write errors
+	~RecordWriter() {
+		if (file != NULL && used > 0)
+			fwrite(buffer.data(), 1, used, file);
+	}
+
+	RecordKind getKind() {
+		return kind;
+	}
+
+	void write(int key) {
+		reserve(4);
+		storeLE(&buffer[used], key);
+		used += 4;
+	}
+
+	void write(int key, int value) {
+		reserve(8);
+		storeLE(&buffer[used], key);
+		storeLE(&buffer[used + 4], value);
+		used += 8;
+	}
+
+	void close() {
+		flush();
+		if (fflush(file) != 0)
+			throw std::runtime_error("failed to write records");
+		file = NULL;
+	}
+};
+
+class RecordReader {
+	FILE *file;
+	RecordKind kind;
+	std::vector<unsigned char> buffer;
+	size_t used;   // bytes of buffer holding data
+	size_t taken;  // bytes of buffer already consumed
+
+	// Makes sure at least 'bytes' unread bytes are buffered, false at a clean end of file
+	bool fill(size_t bytes) {
+		if (used - taken >= bytes)
+			return true;
+		memmove(buffer.data(), buffer.data() + taken, used - taken);
+		used -= taken;
+		taken = 0;
+		used += fread(buffer.data() + used, 1, buffer.size() - used, file);
+		if (used >= bytes)
+			return true;
+		if (ferror(file))
+			throw std::runtime_error("failed to read records");
+		if (used != 0)
+			throw std::runtime_error("truncated record at end of input");
+		return false;
+	}
+
+public:
+	explicit RecordReader(FILE *file) : file(file), buffer(IO_CHUNK), used(0), taken(0) {
+		used = fread(buffer.data(), 1, buffer.size(), file);
+		if (used < 8 || memcmp(buffer.data(), RECORD_MAGIC, 4) != 0)
+			throw std::runtime_error("input is not an EDSA record file");
+		if (buffer[4] != RECORD_VERSION || (buffer[5] != KEYS && buffer[5] != PAIRS))
+			throw std::runtime_error("unsupported EDSA record file version or kind");
+		kind = static_cast<RecordKind>(buffer[5]);
+		taken = 8;
+	}
+
+	RecordKind getKind() {
+		return kind;
+	}
+
+	// Reads the next record, value is left at 0 for a keys only file
+	bool read(int &key, int &value) {
+		size_t bytes = kind == PAIRS ? 8 : 4;
+		if (!fill(bytes))
+			return false;
+		key = loadLE(&buffer[taken]);
+		value = kind == PAIRS ? loadLE(&buffer[taken + 4]) : 0;
+		taken += bytes;
+		return true;
+	}
+};
@@ -0,0 +1,111 @@
+/*
+Memory accounting shared by all the containers.
+Every node (for the skip list the node and its forward pointers as one block) is allocated through one pluggable
+allocator hook, and every allocation is recorded in the MemoryStats of the structure it belongs to.
+Every SkipList owns its MemoryStats and passes it to the nodes it creates. The XOR list and the
+threaded BST have no container object of their own to hold them, so their nodes derive from
+Tracked and the stats are kept per node type, i.e. all XOR lists share one MemoryStats and so on.
+
+	list.memoryStats().liveBytes			bytes currently allocated by this skip list
+	Node::memoryStats().peakBytes			highest liveBytes seen so far for that node type
+	stats.bytesPerElement(n)				liveBytes spread over n elements
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Allocator used for every node, swap it (e.g. for an arena or a pod wide budget allocator)
+// before any container allocates, memory must always be freed by the hook that allocated it
+struct AllocatorHook {
+	void *(*allocate)(size_t bytes);
+	void (*deallocate)(void *ptr, size_t bytes);
+};
+
+inline void *mallocAllocate(size_t bytes) {
+	return std::malloc(bytes);
+}
+
+inline void mallocDeallocate(void *ptr, size_t) {
+	std::free(ptr);
+}
+
+inline AllocatorHook &allocatorHook() {
+	static AllocatorHook hook = {mallocAllocate, mallocDeallocate};
+	return hook;
+}
+
+inline void setAllocatorHook(AllocatorHook hook) {
+	allocatorHook() = hook;
+}
+
+struct MemoryStats {
+	std::atomic<size_t> liveBytes{0};	   // Bytes allocated and not yet freed
+	std::atomic<size_t> peakBytes{0};	   // Highest value liveBytes ever reached
+	std::atomic<size_t> allocations{0};	   // Number of allocations so far
+	std::atomic<size_t> deallocations{0};  // Number of deallocations so far
+
+	void recordAllocate(size_t bytes) {
+		size_t live = liveBytes.fetch_add(bytes) + bytes;
+		allocations++;
+		size_t peak = peakBytes.load();
+		while (live > peak && !peakBytes.compare_exchange_weak(peak, live)) {
+		}
+	}
+
+	void recordDeallocate(size_t bytes) {
+		liveBytes.fetch_sub(bytes);
+		deallocations++;
+	}
+
+	size_t liveAllocations() const {
+		return allocations.load() - deallocations.load();
+	}
+
+	double bytesPerElement(size_t elements) const {
+		return elements == 0 ? 0.0 : double(liveBytes.load()) / elements;
+	}
+
+	void print(const char *name, size_t elements, std::ostream &out = std::cout) const {
+		out << name << ": " << liveBytes.load() << " live bytes, " << peakBytes.load() << " peak bytes, "
+			<< liveAllocations() << " live allocations (" << allocations.load() << " total), "
+			<< bytesPerElement(elements) << " bytes per element" << std::endl;
+	}
+};
+
+inline void *trackedAllocate(MemoryStats &stats, size_t bytes) {
+	void *ptr = allocatorHook().allocate(bytes);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	stats.recordAllocate(bytes);
+	return ptr;
+}
+
+inline void trackedDeallocate(MemoryStats &stats, void *ptr, size_t bytes) {
+	if (ptr == nullptr)
+		return;
+	allocatorHook().deallocate(ptr, bytes);
+	stats.recordDeallocate(bytes);
+}
+
+// Base class for a node type T, routes new/delete of T through the allocator hook
+// and records them in T's own MemoryStats
+template <typename T>
+struct Tracked {
+	static MemoryStats &memoryStats() {
+		static MemoryStats stats;
+		return stats;
+	}
+
+	static void *operator new(size_t bytes) {
+		return trackedAllocate(memoryStats(), bytes);
+	}
+
+	static void operator delete(void *ptr, size_t bytes) {
+		trackedDeallocate(memoryStats(), ptr, bytes);
+	}
+};
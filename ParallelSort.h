@@ -0,0 +1,89 @@
+/*
+Helpers for building the containers in bulk from unsorted input.
+The input is split into one chunk per core, every chunk is sorted on its own thread,
+and the sorted chunks are then merged pairwise, also in parallel, until one run is left.
+Both stable_sort and merge keep equal elements in their original order,
+so the sort is stable which lets parallelSortUnique decide which duplicate survives.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of worker threads to split n items across, so that every thread gets at least 'grain' items
+inline size_t parallelWorkers(size_t n, size_t grain = 1 << 14) {
+	size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+	return std::max<size_t>(1, std::min(cores, n / grain));
+}
+
+// Calls body(lo, hi) for disjoint ranges covering [0, n), each range on its own thread
+template <typename Body>
+void parallelFor(size_t n, Body body) {
+	size_t workers = parallelWorkers(n);
+	if (workers == 1) {
+		body(size_t(0), n);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for (size_t w = 0; w < workers; w++)
+		threads.emplace_back(body, n * w / workers, n * (w + 1) / workers);
+	for (std::thread &t : threads)
+		t.join();
+}
+
+// Stable sort using all cores
+template <typename T, typename Less>
+void parallelSort(std::vector<T> &items, Less less) {
+	size_t n = items.size();
+	size_t runs = parallelWorkers(n);
+
+	// run r is items[bounds[r], bounds[r + 1])
+	std::vector<size_t> bounds;
+	for (size_t r = 0; r <= runs; r++)
+		bounds.push_back(n * r / runs);
+
+	parallelFor(n, [&](size_t lo, size_t hi) {
+		std::stable_sort(items.begin() + lo, items.begin() + hi, less);
+	});
+
+	std::vector<T> buffer(n);
+	while (bounds.size() > 2) {	 // more than one run left
+		std::vector<size_t> merged;
+		std::vector<std::thread> threads;
+		for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+			merged.push_back(bounds[r]);
+			if (r + 2 < bounds.size()) {  // merge runs r and r + 1
+				size_t lo = bounds[r], mid = bounds[r + 1], hi = bounds[r + 2];
+				threads.emplace_back([&, lo, mid, hi] {
+					std::merge(items.begin() + lo, items.begin() + mid, items.begin() + mid, items.begin() + hi, buffer.begin() + lo, less);
+				});
+			} else {  // odd run out, carried over as is
+				std::copy(items.begin() + bounds[r], items.begin() + bounds[r + 1], buffer.begin() + bounds[r]);
+			}
+		}
+		merged.push_back(n);
+		for (std::thread &t : threads)
+			t.join();
+		items.swap(buffer);
+		bounds.swap(merged);
+	}
+}
+
+// Sorts and removes duplicates, out of a group of equal items the one that came last in the input is kept
+template <typename T, typename Less>
+void parallelSortUnique(std::vector<T> &items, Less less) {
+	parallelSort(items, less);
+
+	size_t kept = 0;
+	for (size_t i = 0; i < items.size(); i++) {
+		if (kept > 0 && !less(items[kept - 1], items[i]))
+			items[kept - 1] = items[i];	 // equal to the last kept item, the later one wins
+		else
+			items[kept++] = items[i];
+	}
+	items.resize(kept);
+}
@@ -0,0 +1,366 @@
+/*
+Skip List with a (key, value) per node, see 1-SkipLists.cpp.
+https://blog.reachsumit.com/posts/2020/07/skip-list/
+
+Everything lives in namespace skiplist so that it can be included next to the other containers,
+which define a Node class of their own (5-BulkIO.cpp includes all of them).
+*/
+
+#pragma once
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "MemoryStats.h"
+#include "ParallelSort.h"
+
+namespace skiplist {
+
+using namespace std;
+
+const int MAX_LEVEL = 16;  // Maximum number of levels in the skip list
+/*
+Increasing the value for MAX_LEVEL involves a trade-off between space complexity and search efficiency.
+
+Costs:
+1. Increased Space Complexity: With each additional level, the skip list requires more memory to maintain pointers, increasing space consumption.
+2. Higher Construction Overhead: Constructing a skip list with more levels requires additional time and computational resources.
+3. Potential for Increased Memory Fragmentation: Larger skip lists may suffer from memory fragmentation, especially in environments with limited memory allocation.
+
+Benefits:
+1. Improved Search Efficiency: Higher max levels can reduce the average number of nodes visited during a search operation, leading to faster search times.
+2. Balanced Search Performance: Skip lists maintain logarithmic search time even with increased max levels, ensuring consistent performance.
+3. Reduced Probability of Degenerate Lists: Increasing max levels lowers the likelihood of generating degenerate skip lists, which could otherwise degrade search performance to linear time complexity.
+4. Flexibility for Dynamic Environments: Greater max levels provide flexibility for accommodating future growth and changes in data distribution without significant degradation in search performance.
+
+Determining the optimal value for the MAX_LEVEL in a skip list when the total number of elements is known apriori involves considering the balance between search efficiency and space complexity.
+A popular formula for determining the optimal max levels in a skip list is based on the equation:
+
+	MAX_LEVEL=⌈log⁡2(n)⌉−1max levels=⌈log2​(n)⌉−1
+
+Where:
+	nn is the total number of elements in the skip list.
+	⌈x⌉⌈x⌉ represents the ceiling function, which rounds xx up to the nearest integer.
+
+Explanation:
+	The logarithmic function (log⁡2(n)log2​(n)) provides a good balance between search efficiency and space complexity. It ensures that search operations remain efficient while keeping the space overhead manageable.
+	Subtracting 1 from the result ensures that the maximum number of levels is proportional to the logarithm of the number of elements but still provides a sufficient number of levels for effective searching.
+*/
+
+// Node class for the Skip List
+// the node and its forward array are one block allocated through the allocator hook
+// and counted in the MemoryStats of the Skip List owning the node:
+// key, value and level (padded to 16 bytes) followed by the level + 1 forward pointers
+class alignas(void*) Node {
+public:
+	int key;	// query the key and
+	int value;	// search for value from the skip list
+	int level;	// Highest level of this node, the block holds level + 1 forward pointers
+
+	// Constructor for Node, must only run on a block of blockSize(level) bytes
+	Node(int key, int value, int level) {
+		this->key = key;
+		this->value = value;
+		this->level = level;
+		// to store head pointers for each level of the Skip List
+		for (int i = 0; i <= level; i++) {
+			forward()[i] = nullptr;
+		}
+	}
+
+	// Array of forward pointers, stored right after the node
+	Node** forward() {
+		return reinterpret_cast<Node**>(this + 1);
+	}
+
+	// Bytes taken by a node of the given level, forward pointers included
+	static size_t blockSize(int level) {
+		return sizeof(Node) + (level + 1) * sizeof(Node*);
+	}
+
+	// Allocates a Node, accounted in stats
+	static Node* create(int key, int value, int level, MemoryStats& stats) {
+		return new (trackedAllocate(stats, blockSize(level))) Node(key, value, level);
+	}
+
+	// Frees a Node created with the same stats, the forward array included
+	static void destroy(Node* p, MemoryStats& stats) {
+		size_t bytes = blockSize(p->level);
+		p->~Node();
+		trackedDeallocate(stats, p, bytes);
+	}
+};
+
+// Skip List class
+class SkipList {
+private:
+	MemoryStats stats;	// Memory used by this Skip List, declared first so it outlives the nodes
+	Node* header;		// Head node for the Skip List
+	int level;			// Current level of the Skip List(<=MAX_LEVEL)
+	int size;			// Number of nodes in the Skip List
+
+public:
+	// Constructor for Skip List
+	SkipList() {
+		header = Node::create(0, 0, MAX_LEVEL, stats);
+		level = 0;
+		size = 0;
+	}
+
+	// Destructor for Skip List
+	// removes nodes bottom up
+	// a node stores an array of heads of all nodes below it
+	// so 0th index of such a node in each level will be different!
+	~SkipList() {
+		Node* p = header->forward()[0];
+		while (p) {
+			Node* q = p->forward()[0];
+			Node::destroy(p, stats);
+			p = q;
+		}
+		Node::destroy(header, stats);
+	}
+
+	// Returns the number of nodes in the Skip List
+	int getSize() {
+		return size;
+	}
+
+	// Returns the current level of the Skip List
+	int getLevel() {
+		return level;
+	}
+
+	// Memory used by this Skip List, header node included
+	MemoryStats& memoryStats() {
+		return stats;
+	}
+
+	// Average footprint of one key in this Skip List
+	double bytesPerElement() {
+		return memoryStats().bytesPerElement(size);
+	}
+
+	// Searches for a node with the given key in the Skip List
+	Node* find(int key) {
+		Node* p = header;					// the level with least nodes(on the top)
+		for (int i = level; i >= 0; i--) {	// search from highest to lowest level
+			// if the next key on the same level exists and is smaller than the queried key
+			while (p->forward()[i] && p->forward()[i]->key < key) {
+				p = p->forward()[i];  // fearlessly move to it
+			}						  // else need to go one level down
+		}							  // so either go right or go down
+		return p->forward()[0];
+	}
+
+	// Runs find for every key, out[j] is set to find(keys[j])
+	// A single find is a chain of dependent loads: node (forward pointers included) -> next node -> ...
+	// and the core sits idle on every cache miss along it. Here up to LOOKUPS finds run as
+	// interleaved state machines, each one prefetches the memory its next step needs and then
+	// hands over to the next lookup, so by the time it gets its turn again the load has (mostly)
+	// completed and up to LOOKUPS misses are in flight at once instead of one.
+	void findMany(const vector<int>& keys, vector<Node*>& out) {
+		static const int LOOKUPS = 16;
+		struct Lookup {
+			size_t index;  // position of the key in keys and out
+			Node* p;	   // last node known to have a smaller key
+			Node* next;	   // p->forward()[i], only valid once loaded is set
+			int i;		   // current level
+			bool loaded;   // false while p->forward()[i] is being prefetched
+		};
+
+		out.resize(keys.size());
+		Lookup lookups[LOOKUPS];
+		size_t issued = 0;
+		int active = 0;
+
+		// starts the lookup of the next key in l, the header is always hot so its forward array is read directly
+		auto start = [&](Lookup& l) {
+			l.index = issued++;
+			l.p = header;
+			l.i = level;
+			l.next = header->forward()[level];
+			l.loaded = true;
+			__builtin_prefetch(l.next);
+		};
+
+		while (active < LOOKUPS && issued < keys.size()) {
+			start(lookups[active++]);
+		}
+		while (active > 0) {
+			for (int j = 0; j < active; j++) {
+				Lookup& l = lookups[j];
+				if (!l.loaded) {  // the forward array of p has arrived, read the next node and prefetch it
+					l.next = l.p->forward()[l.i];
+					l.loaded = true;
+					__builtin_prefetch(l.next);
+				} else if (l.next && l.next->key < keys[l.index]) {	 // move right, prefetch the forward array entry of the new p
+					l.p = l.next;
+					l.loaded = false;
+					__builtin_prefetch(&l.p->forward()[l.i]);
+				} else if (l.i > 0) {  // go one level down, p's forward array is already in cache
+					l.i--;
+					l.next = l.p->forward()[l.i];
+					__builtin_prefetch(l.next);
+				} else {  // done, hand the slot over to the next key or retire it
+					out[l.index] = l.next;
+					if (issued < keys.size()) {
+						start(l);
+					} else {
+						l = lookups[--active];
+						j--;  // the lookup moved into slot j has not had its turn yet
+					}
+				}
+			}
+		}
+	}
+
+	int randomLevel() {
+		int level = 0;
+		while (rand() % 2 == 0 && level < MAX_LEVEL) {
+			level++;
+		}
+		return level;
+	}
+
+	// Inserts a new node with the given key and value into the Skip List
+	void insert(int key, int value) {
+		// in a sorted linked list, we would insert the key just after the last key thats smaller than the key to be inserted
+		// here we have multiple layers of sorted linked lists with varying number of nodes in each
+		// so update array stores the address of all such nodes
+		Node* update[MAX_LEVEL + 1];
+		Node* p = header;
+		// going from the layer with least nodes(highest level at the top)
+		// to the lowest layer with most nodes(lowest level at the bottom)
+		for (int i = level; i >= 0; i--) {
+			while (p->forward()[i] && p->forward()[i]->key < key) {
+				p = p->forward()[i];
+			}
+			update[i] = p;	// stores the node that has the largest key thats just smaller than the key to be inserted
+		}
+		// so after the loop, p should be at the lowest node(which has the most nodes and is at the bottom of the skip list)
+		// and p will be poiting the the node with largest key just smaller to the key to be inserted
+		// so the key must be inserted after it
+		p = p->forward()[0];
+		if (p && p->key == key) {  // if the key already exists simply update value
+			p->value = value;
+		} else {  // otherwise insert it randomly in a random level
+			int newLevel = randomLevel();
+			if (newLevel > level) {	 // level < newLevel <= MAX_LEVEL
+				// create the random level if not exists already
+				for (int i = level + 1; i <= newLevel; i++) {
+					update[i] = header;
+				}
+				level = newLevel;
+			}
+			p = Node::create(key, value, newLevel, stats);
+			for (int i = 0; i <= newLevel; i++) {
+				p->forward()[i] = update[i]->forward()[i];	// p points to the node after the node stored in update[]
+				update[i]->forward()[i] = p;				// the node stored in update[] points to p
+			}
+			size++;
+		}
+	}
+
+	// Removes the node with the given key from the Skip List
+	void remove(int key) {
+		Node* update[MAX_LEVEL + 1];
+		Node* p = header;
+		for (int i = level; i >= 0; i--) {
+			while (p->forward()[i] && p->forward()[i]->key < key) {
+				p = p->forward()[i];
+			}
+			update[i] = p;
+		}
+		p = p->forward()[0];
+		if (p && p->key == key) {
+			for (int i = 0; i <= level; i++) {
+				if (update[i]->forward()[i] != p) {
+					break;	// if the node to be deleted is the last in the list or exceeds key
+				}
+				update[i]->forward()[i] = p->forward()[i];
+			}
+			Node::destroy(p, stats);
+			while (level > 0 && header->forward()[level] == nullptr) {
+				level--;  // recount levels as a level might just have a single node that got deleted
+			}
+			size--;
+		}
+	}
+
+	// Inserts all (key, value) pairs at once, for a key given more than once the last value wins
+	// (like calling insert for every pair in order) and the given values overwrite existing ones.
+	// The pairs are sorted and deduplicated on all cores, after that the list is rebuilt in a
+	// single left to right pass: every node is appended to the end of each level it reaches,
+	// so there is no search per key at all.
+	void bulkLoad(vector<pair<int, int>> items) {
+		// existing pairs go first so that the stable sort keeps the new values after them
+		vector<pair<int, int>> all;
+		all.reserve(size + items.size());
+		for (Node* p = header->forward()[0]; p; p = p->forward()[0])
+			all.push_back(make_pair(p->key, p->value));
+		all.insert(all.end(), items.begin(), items.end());
+		items.clear();
+		items.shrink_to_fit();
+
+		parallelSortUnique(all, [](const pair<int, int>& a, const pair<int, int>& b) {
+			return a.first < b.first;
+		});
+
+		// drop the old nodes, only the header is reused
+		Node* p = header->forward()[0];
+		while (p) {
+			Node* q = p->forward()[0];
+			Node::destroy(p, stats);
+			p = q;
+		}
+		for (int i = 0; i <= MAX_LEVEL; i++) {
+			header->forward()[i] = nullptr;
+		}
+		level = 0;
+
+		Node* last[MAX_LEVEL + 1];	// last node of every level so far
+		for (int i = 0; i <= MAX_LEVEL; i++) {
+			last[i] = header;
+		}
+		for (const pair<int, int>& item : all) {
+			int newLevel = randomLevel();
+			if (newLevel > level) {
+				level = newLevel;
+			}
+			p = Node::create(item.first, item.second, newLevel, stats);
+			for (int i = 0; i <= newLevel; i++) {
+				last[i]->forward()[i] = p;
+				last[i] = p;
+			}
+		}
+		size = all.size();
+	}
+
+	// Calls visit(key, value) for every node in increasing key order
+	template <typename Visitor>
+	void forEach(Visitor visit) {
+		for (Node* p = header->forward()[0]; p; p = p->forward()[0]) {
+			visit(p->key, p->value);
+		}
+	}
+
+	// print the Skip List
+	void print() {
+		for (int i = 0; i <= level; i++) {
+			Node* p = header->forward()[i];
+			cout << "Level " << i << ": ";
+			while (p) {
+				cout << "(" << p->key << ", " << p->value << ") ";
+				p = p->forward()[i];
+			}
+			cout << endl;
+		}
+	}
+};
+
+}  // namespace skiplist
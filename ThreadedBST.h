@@ -0,0 +1,1158 @@
+/*
+Threaded binary search tree with order statistics, its frozen (Eytzinger) snapshot and a
+variant with lock free readers, see 4-ThreadedBinaryTree.cpp.
+
+Everything lives in namespace tbt so that it can be included next to the other containers,
+which define a Node class of their own (5-BulkIO.cpp includes all of them).
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "MemoryStats.h"
+#include "ParallelSort.h"
+
+namespace tbt {
+
+using namespace std;
+
+class FrozenThreadedBST;
+
+// every node is allocated through the allocator hook and counted in Node::memoryStats(),
+// one allocation per key so memoryStats().liveAllocations() is the number of keys in all trees
+class Node : public Tracked<Node> {
+public:
+	Node *left, *right;
+	int info;
+	bool lthread;  // True if left pointer points to predecessor in Inorder Traversal
+	bool rthread;  // True if right pointer points to successor in Inorder Traversal
+	int size;	   // Number of nodes in the subtree rooted at this Node (including itself)
+
+	Node() {
+	}
+
+	explicit Node(int data) {
+		info = data;
+		left = NULL;
+		right = NULL;
+		lthread = true;
+		rthread = true;
+		size = 1;
+	}
+
+	// Size of the left subtree, a threaded left pointer means there is no left subtree
+	int leftSize(Node *ptr) {
+		return ptr->lthread == false ? ptr->left->size : 0;
+	}
+
+	// Insert a Node in Binary Threaded Tree
+	Node *insert(Node *root, int ikey) {
+		// Searching for a Node with given value
+		Node *ptr = root;
+		Node *par = NULL;  // Parent of key to be inserted
+		while (ptr != NULL) {
+			// If key already exists, return
+			if (ikey == ptr->info) {
+				cout << "Duplicate Key!" << endl;
+				return root;
+			}
+
+			par = ptr;	// Update parent pointer
+
+			// Update ptr only if the child is not threaded
+			if (ikey < ptr->info) {	 // Moving on left subtree.
+				if (ptr->lthread == false)
+					ptr = ptr->left;
+				else
+					break;
+			} else {  // Moving on right subtree.
+				if (ptr->rthread == false)
+					ptr = ptr->right;
+				else
+					break;
+			}
+		}  // this loop stops when ptr becoms null making par the actual point of insertion
+
+		// the key is not a duplicate, so every node on the path from root to par gains one descendant
+		// (any rotation added later must recompute size for the nodes it moves, bottom up)
+		for (Node *anc = root; par != NULL; anc = ikey < anc->info ? anc->left : anc->right) {
+			anc->size++;
+			if (anc == par)
+				break;
+		}
+
+		// Create a new Node
+		Node *tmp = new Node;
+		tmp->info = ikey;
+		tmp->lthread = true;
+		tmp->rthread = true;
+		tmp->size = 1;
+
+		// the new node will always be attached as a leaf node to the tree as its a BST
+		// if a node is attached to the left, then:
+		// 			the parent is no longer threaded on its left, and instead points to its new left child
+		//			the left of new node is threaded to point back to the parent's left (Predecessor)
+		// 			the right of the new node is threaded to point back to its parent (Successor)
+		// if a node is attached to the right, then
+		//			the parent is no longer threaded on its right, and instead points ot its right child
+		//			the left of the new node is threaded to point back to its parent (Predecessor)
+		// 			the right of the new node is threaded to point back to the parent's right (Successor)
+
+		if (par == NULL) {	// For Empty Tree
+			root = tmp;
+			tmp->left = NULL;
+			tmp->right = NULL;
+		} else if (ikey < (par->info)) {  // attach new node to the left
+			tmp->left = par->left;		  // Predecessor
+			tmp->right = par;			  // Successor
+			par->lthread = false;		  // lthread is converted to left link
+			par->left = tmp;			  // Tmp will become left child.
+		} else {						  // ikey > (par->info), not >=, as already checked for duplicates, attach new node to the right
+			tmp->left = par;			  // Parent will become the predecessor for its right child.
+			tmp->right = par->right;	  // right pointer will Point to Successor
+			par->rthread = false;		  // Convert Thread to link.
+			par->right = tmp;			  // New node will become right child of parent.
+		}
+		return root;
+	}
+
+	// The recursive traversals below need stack space proportional to the height of the tree
+	// and will overflow it on a degenerate one, the visit* functions further down run in O(1) space
+
+	// Recursive Inorder Traversing(without exploiting the threaded nature of the BST)
+	void nonThreadedInorder(Node *root) {
+		if (root == NULL)
+			return;
+		// First recur on left subtree
+		if (root->lthread == false)
+			nonThreadedInorder(root->left);
+		// Then read the data of child
+		cout << root->info << " ";
+		// Recur on the right subtree
+		if (root->rthread == false)
+			nonThreadedInorder(root->right);
+	}
+
+	// Recursive Preorder Traversing(without exploiting the threaded nature of the BST)
+	void nonThreadedPreorder(Node *root) {
+		if (root == NULL)
+			return;
+		// First read the data of child
+		cout << root->info << " ";
+		// Then recur on left subtree
+		if (root->lthread == false)
+			nonThreadedPreorder(root->left);
+		// Then Recur on the right subtree
+		if (root->rthread == false)
+			nonThreadedPreorder(root->right);
+	}
+
+	// Recursive Podtorder Traversing(without exploiting the threaded nature of the BST)
+	void nonThreadedPostorder(Node *root) {
+		if (root == NULL)
+			return;
+		// Then recur on left subtree
+		if (root->lthread == false)
+			nonThreadedPostorder(root->left);
+		// Then Recur on the right subtree
+		if (root->rthread == false)
+			nonThreadedPostorder(root->right);
+		// First read the data of child
+		cout << root->info << " ";
+	}
+
+	// Returns inorder successor using rthread (Used in inorder and deletion)
+	// static as deleteTree keeps calling it after the Node it was called on may have been freed
+	static Node *getInorderSuccessor(Node *ptr) {
+		// If rthread is set, we can quickly find
+		if (ptr->rthread == true)
+			return ptr->right;
+
+		// Else return leftmost child of right subtree
+		ptr = ptr->right;
+		while (ptr->lthread == false)
+			ptr = ptr->left;
+		return ptr;
+	}
+
+	// Non-recursive Printing the threaded tree in Inorder
+	void threadedInorder(Node *root) {
+		if (root == NULL) {
+			cout << "Tree is empty" << endl;
+			return;
+		}
+		visitInorder(root, [](int info) { cout << info << " "; });
+	}
+
+	// Non-recursive Preorder Traversal of TBT
+	void threadedPreorder(Node *root) {
+		if (root == NULL) {
+			cout << "Tree is empty";
+			return;
+		}
+		visitPreorder(root, [](int info) { cout << info << " "; });
+	}
+
+	// Non-recursive Postorder Traversal of TBT
+	void threadedPostorder(Node *root) {
+		if (root == NULL) {
+			cout << "Tree is empty";
+			return;
+		}
+		visitPostorder(root, [](int info) { cout << info << " "; });
+	}
+
+	/*
+	Traversal engine: every visit* function calls visit(info) once per key, in the order of the traversal.
+	None of them recurse or allocate (except level order).
+	The visitor must not modify the tree while it is being traversed, and the visitor of
+	visitPostorder must not access the tree at all, not even to read it: the right links of
+	the spine being visited are reversed while the visitor runs. For the same reason no other
+	thread may read the tree while visitPostorder runs, it is the only traversal that writes to it.
+	*/
+
+	// Inorder: start at the leftmost node and keep following successors
+	template <typename Visitor>
+	void visitInorder(Node *root, Visitor visit) {
+		if (root == NULL)
+			return;
+
+		Node *ptr = root;
+		while (ptr->lthread == false)
+			ptr = ptr->left;
+
+		while (ptr != NULL) {
+			visit(ptr->info);
+			ptr = getInorderSuccessor(ptr);
+		}
+	}
+
+	// Preorder: go left while possible, else right, else climb the right threads
+	// to the first ancestor whose right subtree is still unexplored
+	template <typename Visitor>
+	void visitPreorder(Node *root, Visitor visit) {
+		Node *ptr = root;
+		while (ptr != NULL) {
+			visit(ptr->info);
+			if (ptr->lthread == false)
+				ptr = ptr->left;
+			else if (ptr->rthread == false)
+				ptr = ptr->right;
+			else {
+				while (ptr != NULL && ptr->rthread == true)
+					ptr = ptr->right;  // go to successor / parent
+				if (ptr != NULL)
+					ptr = ptr->right;  // go to right child of successor / parent
+			}
+		}
+	}
+
+	/*
+	Postorder: every node lies on exactly one right spine, i.e. a chain that starts at a left child
+	(or at the root) and keeps going down right links until a node whose right pointer is a thread.
+	Walking the tree in inorder, following a right thread out of a spine means the whole subtree
+	hanging off the top of that spine is finished, and postorder of that subtree ends with the spine
+	read bottom up. The spine is read bottom up in O(1) space by temporarily reversing its right links.
+				a
+			   / \
+			  b   c			spines: (a, c) (b, e) (d) (f)
+			 / \
+			d   e			inorder d b f e a c, leaving e by its thread to a emits e b,
+			   /			leaving c by its NULL thread emits c a
+			  f
+	*/
+	template <typename Visitor>
+	void visitPostorder(Node *root, Visitor visit) {
+		if (root == NULL)
+			return;
+
+		Node *ptr = root;
+		while (ptr->lthread == false)
+			ptr = ptr->left;
+
+		while (ptr != NULL) {
+			if (ptr->rthread == false) {  // not the end of a spine, move on to the leftmost node of the right subtree
+				ptr = ptr->right;
+				while (ptr->lthread == false)
+					ptr = ptr->left;
+			} else {  // the thread leads out of the spine that ends at ptr
+				Node *next = ptr->right;
+				visitSpineBottomUp(next == NULL ? root : next->left, ptr, visit);
+				ptr = next;
+			}
+		}
+	}
+
+	// Climbs a reversed right spine from bottom to top, putting every right link back on the way.
+	// Whatever is still reversed is put back by the destructor, so the tree is restored
+	// even when the visitor throws halfway up the spine
+	struct SpineRestorer {
+		Node *top;
+		Node *ptr;	  // next node to restore, NULL once the whole spine is back in place
+		Node *below;  // what ptr->right has to point to again
+
+		SpineRestorer(Node *top, Node *bottom, Node *saved) : top(top), ptr(bottom), below(saved) {
+		}
+
+		void restoreOne() {
+			Node *above = ptr->right;
+			ptr->right = below;
+			if (ptr == top) {
+				ptr = NULL;
+			} else {
+				below = ptr;
+				ptr = above;
+			}
+		}
+
+		~SpineRestorer() {
+			while (ptr != NULL)
+				restoreOne();
+		}
+	};
+
+	// Visits the right spine from top down to bottom in reverse, leaving the links as they were
+	// once it returns or throws (they are reversed while visit runs)
+	template <typename Visitor>
+	void visitSpineBottomUp(Node *top, Node *bottom, Visitor visit) {
+		Node *saved = bottom->right;  // thread out of the spine
+
+		// reverse the right links so that every spine node points to the one above it
+		Node *prev = top;
+		Node *ptr = top->right;
+		while (prev != bottom) {
+			Node *next = ptr->right;
+			ptr->right = prev;
+			prev = ptr;
+			ptr = next;
+		}
+
+		// climb back up, visiting and restoring the links on the way
+		SpineRestorer spine(top, bottom, saved);
+		while (spine.ptr != NULL) {
+			visit(spine.ptr->info);
+			spine.restoreOne();
+		}
+	}
+
+	// Level order: calls visit(info, level) with the root at level 0,
+	// only real child links are followed so the queue never holds more than two levels
+	template <typename Visitor>
+	void visitLevelOrder(Node *root, Visitor visit) {
+		if (root == NULL)
+			return;
+
+		queue<Node *> q;
+		q.push(root);
+		for (int level = 0; q.empty() == false; level++) {
+			for (size_t width = q.size(); width > 0; width--) {
+				Node *node = q.front();
+				q.pop();
+				visit(node->info, level);
+				if (node->lthread == false)
+					q.push(node->left);
+				if (node->rthread == false)
+					q.push(node->right);
+			}
+		}
+	}
+
+	// Frees every node of the tree in O(1) space: nodes are freed in inorder and the successor
+	// of a node is always found through nodes that come after it, which are still alive
+	void deleteTree(Node *root) {
+		if (root == NULL)
+			return;
+
+		Node *ptr = root;
+		while (ptr->lthread == false)
+			ptr = ptr->left;
+
+		while (ptr != NULL) {
+			Node *next = getInorderSuccessor(ptr);
+			delete ptr;
+			ptr = next;
+		}
+	}
+
+	// Inserts all keys at once and returns the new root, duplicates are ignored like in insert.
+	// The keys (together with the ones already in the tree) are sorted and deduplicated on all
+	// cores, then a perfectly balanced tree is built directly from the sorted keys in linear time:
+	// the middle key becomes the root and both halves are built the same way, the top
+	// levels in parallel. The old nodes are freed, the tree is rebuilt from scratch.
+	Node *bulkLoad(Node *root, vector<int> keys) {
+		visitInorder(root, [&keys](int info) { keys.push_back(info); });
+		deleteTree(root);
+		parallelSortUnique(keys, less<int>());
+		if (keys.empty())
+			return NULL;
+
+		vector<Node *> nodes(keys.size());
+		parallelFor(keys.size(), [&nodes, &keys](size_t lo, size_t hi) {
+			for (size_t i = lo; i < hi; i++)
+				nodes[i] = new Node(keys[i]);
+		});
+
+		// every level of the recursion doubles the number of threads working on it
+		int spawnDepth = 0;
+		while ((size_t(1) << spawnDepth) < parallelWorkers(keys.size()))
+			spawnDepth++;
+		return linkBalanced(nodes, 0, keys.size() - 1, spawnDepth);
+	}
+
+	// Links nodes[lo..hi] into a balanced subtree and returns its root, a missing child becomes
+	// a thread to the neighbouring entry of nodes as that is the inorder predecessor / successor
+	// (static as bulkLoad may have freed the Node it was called on, e.g. root->bulkLoad(root, keys))
+	static Node *linkBalanced(vector<Node *> &nodes, int lo, int hi, int spawnDepth) {
+		int mid = lo + (hi - lo) / 2;
+		Node *ptr = nodes[mid];
+		ptr->size = hi - lo + 1;
+
+		thread leftBuilder;
+		if (lo < mid) {
+			ptr->lthread = false;
+			if (spawnDepth > 0)
+				leftBuilder = thread([&nodes, ptr, lo, mid, spawnDepth] {
+					ptr->left = linkBalanced(nodes, lo, mid - 1, spawnDepth - 1);
+				});
+			else
+				ptr->left = linkBalanced(nodes, lo, mid - 1, 0);
+		} else {
+			ptr->lthread = true;
+			ptr->left = mid > 0 ? nodes[mid - 1] : NULL;
+		}
+
+		if (mid < hi) {
+			ptr->rthread = false;
+			ptr->right = linkBalanced(nodes, mid + 1, hi, spawnDepth > 0 ? spawnDepth - 1 : 0);
+		} else {
+			ptr->rthread = true;
+			ptr->right = mid + 1 < (int)nodes.size() ? nodes[mid + 1] : NULL;
+		}
+
+		if (leftBuilder.joinable())
+			leftBuilder.join();
+		return ptr;
+	}
+
+	// Returns inorder predessor using left and right children (Used in deletion)
+	Node *getInorderPredecessor(Node *ptr) {
+		if (ptr->lthread == true)
+			return ptr->left;
+
+		ptr = ptr->left;
+		while (ptr->rthread == false)
+			ptr = ptr->right;
+
+		return ptr;
+	}
+
+	// Here 'par' is pointer to parent Node and 'ptr' is pointer to current Node.
+	Node *caseA(Node *root, Node *par, Node *ptr) {	 // No Children of the node to be deleted
+		// If Node to be deleted is root
+		if (par == NULL)
+			root = NULL;
+
+		// If Node to be deleted is left of its parent
+		else if (ptr == par->left) {
+			par->lthread = true;
+			par->left = ptr->left;
+		} else {
+			par->rthread = true;
+			par->right = ptr->right;
+		}
+
+		// Free memory and return new root
+		delete ptr;
+
+		return root;
+	}
+
+	// Here 'par' is pointer to parent Node and 'ptr' is pointer to current Node.
+	Node *caseB(Node *root, Node *par, Node *ptr) {	 // One Child of the node to be deleted
+		Node *child;
+
+		// Initialize child Node to be deleted has left child.
+		if (ptr->lthread == false)
+			child = ptr->left;
+
+		// Node to be deleted has right child.
+		else
+			child = ptr->right;
+
+		// Node to be deleted is root Node.
+		if (par == NULL)
+			root = child;
+
+		// Node is left child of its parent.
+		else if (ptr == par->left)
+			par->left = child;
+		else
+			par->right = child;
+
+		// Find successor and predecessor
+		Node *s = getInorderSuccessor(ptr);
+		Node *p = getInorderPredecessor(ptr);
+
+		// If ptr has left subtree.
+		if (ptr->lthread == false)
+			p->right = s;
+		// If ptr has right subtree.
+		else if (ptr->rthread == false)
+			s->left = p;
+
+		delete ptr;
+
+		return root;
+	}
+
+	// Here 'par' is pointer to parent Node and 'ptr' is pointer to current Node.
+	Node *caseC(Node *root, Node *ptr) {  // Two Children of the node to be deleted
+		// Find inorder successor and its parent.
+		Node *parsucc = ptr;
+		Node *succ = ptr->right;
+
+		// ptr stays in place and only takes over the key, the node physically
+		// removed is succ so ptr and every node between ptr and succ lose one descendant
+		ptr->size--;
+
+		// Find leftmost child of successor
+		while (succ->lthread == false) {
+			parsucc = succ;
+			parsucc->size--;
+			succ = succ->left;
+		}
+
+		ptr->info = succ->info;
+
+		if (succ->lthread == true && succ->rthread == true)
+			root = caseA(root, parsucc, succ);
+		else
+			root = caseB(root, parsucc, succ);
+
+		return root;
+	}
+
+	// Deletes a key from threaded BST with given root and
+	// returns new root of BST.
+	Node *delThreadedBST(Node *root, int dkey) {
+		// Initialize parent as NULL and ptrent Node as root.
+		Node *par = NULL, *ptr = root;
+
+		// Set true if key is found
+		int found = 0;
+
+		// Search key in BST : find Node and its parent.
+		while (ptr != NULL) {
+			if (dkey == ptr->info) {
+				found = 1;
+				break;
+			}
+			par = ptr;
+			if (dkey < ptr->info) {
+				if (ptr->lthread == false)
+					ptr = ptr->left;
+				else
+					break;
+			} else {
+				if (ptr->rthread == false)
+					ptr = ptr->right;
+				else
+					break;
+			}
+		}
+
+		if (found == 0) {
+			cout << "key not present in tree" << endl;
+			return root;
+		}
+
+		// Every proper ancestor of ptr loses one descendant
+		for (Node *anc = root; anc != ptr; anc = dkey < anc->info ? anc->left : anc->right)
+			anc->size--;
+
+		// Two Children
+		if (ptr->lthread == false && ptr->rthread == false)
+			root = caseC(root, ptr);
+
+		// Only Left Child
+		else if (ptr->lthread == false)
+			root = caseB(root, par, ptr);
+
+		// Only Right Child
+		else if (ptr->rthread == false)
+			root = caseB(root, par, ptr);
+
+		// No child
+		else
+			root = caseA(root, par, ptr);
+
+		return root;
+	}
+
+	// Searching in TBT
+	Node *search(Node *root, int key) {
+		if (root == NULL || root->info == key)
+			return root;
+
+		// Key is greater than root's data
+		if (root->info < key && root->rthread == false)
+			return search(root->right, key);
+
+		// Key is smaller than root's data
+		else if (root->info > key && root->lthread == false)
+			return search(root->left, key);
+
+		return nullptr;
+	}
+
+	// Returns the Node holding the k-th smallest key (1-based), NULL if k is out of range
+	Node *kth(Node *root, int k) {
+		if (root == NULL || k < 1 || k > root->size)
+			return NULL;
+
+		Node *ptr = root;
+		while (true) {
+			int before = leftSize(ptr);	 // keys in the left subtree come before ptr
+			if (k == before + 1)
+				return ptr;
+			if (k <= before) {
+				ptr = ptr->left;
+			} else {  // skip the left subtree and ptr itself
+				k -= before + 1;
+				ptr = ptr->right;
+			}
+		}
+	}
+
+	// Number of keys strictly smaller than key (or smaller or equal when inclusive is set)
+	// key does not have to be present in the tree
+	int countBelow(Node *root, int key, bool inclusive) {
+		int below = 0;
+		Node *ptr = root;
+		while (ptr != NULL) {
+			if (key < ptr->info || (key == ptr->info && inclusive == false)) {
+				if (ptr->lthread == true)
+					break;
+				ptr = ptr->left;
+			} else {  // ptr and its whole left subtree are below key
+				below += leftSize(ptr) + 1;
+				if (key == ptr->info || ptr->rthread == true)
+					break;
+				ptr = ptr->right;
+			}
+		}
+		return below;
+	}
+
+	// Rank of key, i.e. the number of keys strictly smaller than it
+	// so rank of a present key is its 0-based position in the inorder sequence
+	int rank(Node *root, int key) {
+		return countBelow(root, key, false);
+	}
+
+	// Number of keys in the closed range [lo, hi]
+	int count(Node *root, int lo, int hi) {
+		if (lo > hi)
+			return 0;
+		return countBelow(root, hi, true) - countBelow(root, lo, false);
+	}
+
+	// Exports the tree into an immutable, read optimized array (see FrozenThreadedBST)
+	FrozenThreadedBST freeze(Node *root);
+
+	// Level Order Printing
+	void printLevelOrder(Node *root) {
+		int printed = -1;  // last level that has been started
+		visitLevelOrder(root, [&printed](int info, int level) {
+			if (level != printed) {
+				cout << " ===> ";
+				printed = level;
+			}
+			cout << info << " ";
+		});
+	}
+};
+
+/*
+A frozen threaded BST is a read only snapshot of the keys laid out in Eytzinger (BFS) order:
+the root is stored at index 1 and the children of index k are stored at 2k and 2k+1.
+	index:	1	2	3	4	5	6	7
+	key:	40	20	60	10	30	50	70
+No pointers are stored at all, so a search is a chain of index computations over one flat
+array instead of a chain of dependent pointer loads through nodes scattered over the heap.
+The top levels of the implicit tree share a handful of cache lines that stay hot, and the
+16 great-great-grandchildren of index k are the 16 consecutive ints starting at 16k,
+which is exactly one 64 byte cache line when the array is 64 byte aligned,
+so they can be prefetched 4 levels before the search actually reaches them.
+*/
+class FrozenThreadedBST {
+	static const int CACHE_LINE = 64;
+	static const int LANES = 16;  // Searches interleaved by searchBatch
+
+	int *tree;	 // tree[1..n] holds the keys in Eytzinger order, the rest is padding
+	int n;		 // Number of keys
+	int levels;	 // Number of levels of the implicit tree, floor(log2(n)) + 1
+
+	// Moves one level down, the comparison result picks the child instead of a branch
+	// once k runs past the last key it stays put so every lane can run the same number of steps.
+	// Slot indices are size_t: with n close to INT_MAX both 2k and 16k overflow an int
+	inline size_t step(size_t k, int key) const {
+		__builtin_prefetch(tree + 16 * k);
+		size_t next = 2 * k + (tree[k] < key);
+		return k <= size_t(n) ? next : k;
+	}
+
+	// After the descent the path taken is encoded in the bits of k, every right turn is a 1 bit.
+	// The lower bound is the node where the last left turn was taken, so strip the trailing 1s and then that 0
+	inline bool found(size_t k, int key) const {
+		k >>= __builtin_ffsll(~k);
+		return k != 0 && tree[k] == key;
+	}
+
+public:
+	// Fills the array in a single threaded inorder pass of the tree,
+	// walking the implicit tree in inorder alongside so each key lands directly in its final slot
+	explicit FrozenThreadedBST(Node *root) {
+		n = root == NULL ? 0 : root->size;
+		levels = 0;
+		while ((n >> levels) != 0)
+			levels++;
+
+		// 2^levels slots so that step() can always read tree[k] even after running past the last key
+		size_t slots = size_t(1) << levels;
+		tree = static_cast<int *>(::operator new[](slots * sizeof(int), align_val_t(CACHE_LINE)));
+		fill(tree, tree + slots, 0);
+		if (n == 0)
+			return;
+
+		Node *ptr = root;
+		while (ptr->lthread == false)
+			ptr = ptr->left;
+
+		size_t k = 1;  // leftmost slot of the implicit tree
+		while (2 * k <= size_t(n))
+			k = 2 * k;
+		while (ptr != NULL) {
+			tree[k] = ptr->info;
+			ptr = root->getInorderSuccessor(ptr);
+
+			// inorder successor of slot k in the implicit tree
+			if (2 * k + 1 <= size_t(n)) {  // leftmost slot of the right subtree
+				k = 2 * k + 1;
+				while (2 * k <= size_t(n))
+					k = 2 * k;
+			} else {  // climb up while k is a right child, then once more to the parent
+				while (k & 1)
+					k >>= 1;
+				k >>= 1;
+			}
+		}
+	}
+
+	FrozenThreadedBST(FrozenThreadedBST &&other) noexcept : tree(other.tree), n(other.n), levels(other.levels) {
+		other.tree = NULL;
+		other.n = 0;
+		other.levels = 0;
+	}
+
+	FrozenThreadedBST(const FrozenThreadedBST &) = delete;
+	FrozenThreadedBST &operator=(const FrozenThreadedBST &) = delete;
+
+	~FrozenThreadedBST() {
+		::operator delete[](tree, align_val_t(CACHE_LINE));
+	}
+
+	int getSize() {
+		return n;
+	}
+
+	// Branch free search, every lookup takes exactly 'levels' steps
+	bool search(int key) const {
+		size_t k = 1;
+		for (int i = 0; i < levels; i++)
+			k = step(k, key);
+		return found(k, key);
+	}
+
+	// Searches LANES keys in lockstep, so the cache misses of the independent lookups overlap
+	// instead of each lookup waiting for its own miss before the next one can start
+	vector<bool> searchBatch(const vector<int> &keys) const {
+		vector<bool> result(keys.size());
+		size_t k[LANES];
+		for (size_t base = 0; base < keys.size(); base += LANES) {
+			int lanes = min<size_t>(LANES, keys.size() - base);
+			const int *key = keys.data() + base;
+
+			for (int j = 0; j < lanes; j++)
+				k[j] = 1;
+			for (int i = 0; i < levels; i++)
+				for (int j = 0; j < lanes; j++)
+					k[j] = step(k[j], key[j]);
+			for (int j = 0; j < lanes; j++)
+				result[base + j] = found(k[j], key[j]);
+		}
+		return result;
+	}
+};
+
+inline FrozenThreadedBST Node::freeze(Node *root) {
+	return FrozenThreadedBST(root);
+}
+
+/*
+Threaded inorder traversal needs no stack, so a reader only ever holds one node pointer at a time.
+That makes the threaded BST a natural fit for lock free readers, provided that:
+1. a reader never sees a half updated link, the threaded BST needs the pointer and its thread
+   flag to change together, so both are packed into one atomic word (the thread flag lives in
+   the lowest bit, which is always 0 in a Node address) and every link change is a single store.
+2. a reader never sees a half updated key, keys are never written after a node is published.
+   Deleting a node with two children used to copy the successor's key into it (caseC),
+   instead a fresh node holding the successor's key is swapped in for it.
+3. a node is never freed while a reader may still be standing on it, unlinked nodes are
+   retired and only freed after a grace period, i.e. once every reader that could have
+   seen them has left its read section.
+
+Writers are serialized by a mutex (a single writer at a time) and publish every change with a
+release store, readers use acquire loads and take no locks at all.
+A scan running concurrently with a delete may still visit the deleted key, and while a node
+is being swapped in it may meet the successor's key twice, so scans skip keys that are not
+strictly increasing to always report a sorted sequence.
+A key that is in the tree both before and after a change is never missed: the swapped out node
+still leads to the successor, so the successor is only unlinked after a full grace period,
+once no reader can still be standing on the swapped out node (copy, wait, then unlink).
+*/
+class ConcurrentThreadedBST {
+	struct CNode : Tracked<CNode> {
+		const int info;
+		atomic<uintptr_t> left;	  // Left child, or the inorder predecessor when the THREAD bit is set
+		atomic<uintptr_t> right;  // Right child, or the inorder successor when the THREAD bit is set
+
+		explicit CNode(int data) : info(data), left(THREAD), right(THREAD) {
+		}
+	};
+
+	static const uintptr_t THREAD = 1;
+	static const int MAX_READERS = 64;		// Reader threads alive at the same time, across all trees of the process
+	static const size_t RECLAIM_BATCH = 64;	// Retired nodes that trigger a grace period
+
+	atomic<CNode *> root;
+	mutex writer;
+	atomic<uint64_t> epoch;
+	// Epoch seen by each reader on entry, 0 outside a read section.
+	// Every slot gets a cache line of its own so readers on different cores don't invalidate each other's
+	struct alignas(64) ReaderSlot {
+		atomic<uint64_t> epoch;
+	};
+	ReaderSlot readerEpoch[MAX_READERS];
+	vector<CNode *> retired;					// Unlinked nodes waiting for a grace period
+
+	static uintptr_t link(CNode *ptr) {
+		return reinterpret_cast<uintptr_t>(ptr);
+	}
+
+	static uintptr_t thread(CNode *ptr) {
+		return reinterpret_cast<uintptr_t>(ptr) | THREAD;
+	}
+
+	static CNode *target(uintptr_t word) {
+		return reinterpret_cast<CNode *>(word & ~THREAD);
+	}
+
+	static bool isThread(uintptr_t word) {
+		return (word & THREAD) != 0;
+	}
+
+	// Slot numbers not owned by any live thread
+	static mutex &slotLock() {
+		static mutex lock;
+		return lock;
+	}
+
+	static vector<int> &freeSlots() {
+		static vector<int> slots;
+		return slots;
+	}
+
+	// Owns a slot for the lifetime of its thread and gives it back when the thread exits,
+	// so a thread pool recycling its workers never runs out of slots
+	struct SlotOwner {
+		int slot;
+
+		SlotOwner() {
+			static int nextSlot = 0;
+			lock_guard<mutex> lock(slotLock());
+			if (!freeSlots().empty()) {
+				slot = freeSlots().back();
+				freeSlots().pop_back();
+			} else if (nextSlot < MAX_READERS) {
+				slot = nextSlot++;
+			} else {
+				throw runtime_error("too many reader threads for ConcurrentThreadedBST");
+			}
+		}
+
+		~SlotOwner() {
+			lock_guard<mutex> lock(slotLock());
+			freeSlots().push_back(slot);
+		}
+	};
+
+	// Every reader thread gets its own slot, shared by all trees
+	static int readerSlot() {
+		thread_local SlotOwner owner;
+		return owner.slot;
+	}
+
+	// Marks the calling thread as reading for as long as it lives.
+	// Read sections nest (e.g. a scan visitor calling search on the same tree): only the
+	// outermost guard publishes the epoch and clears it, an inner one finds the slot already set
+	class ReadGuard {
+		atomic<uint64_t> &slot;
+		bool outermost;
+
+	public:
+		explicit ReadGuard(ConcurrentThreadedBST &tree) : slot(tree.readerEpoch[readerSlot()].epoch) {
+			outermost = slot.load(memory_order_relaxed) == 0;  // only this thread ever writes its slot
+			if (!outermost)
+				return;
+
+			// re-check the epoch so a writer that bumped it before the slot was visible
+			// cannot have missed this reader while waiting for the grace period
+			uint64_t seen;
+			do {
+				seen = tree.epoch.load();
+				slot.store(seen);
+			} while (tree.epoch.load() != seen);
+		}
+
+		~ReadGuard() {
+			if (outermost)
+				slot.store(0, memory_order_release);
+		}
+	};
+
+	CNode *leftmost(CNode *ptr) {
+		for (uintptr_t word = ptr->left.load(memory_order_acquire); !isThread(word); word = ptr->left.load(memory_order_acquire))
+			ptr = target(word);
+		return ptr;
+	}
+
+	CNode *rightmost(CNode *ptr) {
+		for (uintptr_t word = ptr->right.load(memory_order_acquire); !isThread(word); word = ptr->right.load(memory_order_acquire))
+			ptr = target(word);
+		return ptr;
+	}
+
+	CNode *getInorderSuccessor(CNode *ptr) {
+		uintptr_t word = ptr->right.load(memory_order_acquire);
+		return isThread(word) ? target(word) : leftmost(target(word));
+	}
+
+	CNode *getInorderPredecessor(CNode *ptr) {
+		uintptr_t word = ptr->left.load(memory_order_acquire);
+		return isThread(word) ? target(word) : rightmost(target(word));
+	}
+
+	// Replaces the link from par (or the root) to ptr with word
+	void replaceChild(CNode *par, CNode *ptr, uintptr_t word) {
+		if (par == NULL)
+			root.store(target(word), memory_order_release);
+		else if (par->left.load(memory_order_relaxed) == link(ptr))
+			par->left.store(word, memory_order_release);
+		else
+			par->right.store(word, memory_order_release);
+	}
+
+	void retire(CNode *ptr) {
+		retired.push_back(ptr);
+		if (retired.size() >= RECLAIM_BATCH)
+			synchronize();
+	}
+
+	// Waits until every reader that entered before the epoch bump has left, then frees the retired nodes
+	// (must not be called from inside a read section, it would wait for itself)
+	void synchronize() {
+		uint64_t current = epoch.fetch_add(1) + 1;
+		for (int i = 0; i < MAX_READERS; i++) {
+			uint64_t seen = readerEpoch[i].epoch.load();
+			while (seen != 0 && seen < current) {
+				this_thread::yield();
+				seen = readerEpoch[i].epoch.load();
+			}
+		}
+		for (CNode *ptr : retired)
+			delete ptr;
+		retired.clear();
+	}
+
+public:
+	// Memory used by the nodes of all concurrent trees, retired nodes included until they are reclaimed
+	static MemoryStats &memoryStats() {
+		return CNode::memoryStats();
+	}
+
+	ConcurrentThreadedBST() : root(NULL), epoch(1) {
+		for (int i = 0; i < MAX_READERS; i++)
+			readerEpoch[i].epoch.store(0);
+	}
+
+	ConcurrentThreadedBST(const ConcurrentThreadedBST &) = delete;
+	ConcurrentThreadedBST &operator=(const ConcurrentThreadedBST &) = delete;
+
+	// No reader or writer may be running while the tree is destroyed
+	~ConcurrentThreadedBST() {
+		CNode *ptr = root.load();
+		if (ptr != NULL)
+			ptr = leftmost(ptr);
+		while (ptr != NULL) {  // the successor of a node never goes back into the already freed part
+			CNode *next = getInorderSuccessor(ptr);
+			delete ptr;
+			ptr = next;
+		}
+		for (CNode *ptr : retired)
+			delete ptr;
+	}
+
+	// Lock free lookup
+	bool search(int key) {
+		ReadGuard guard(*this);
+		CNode *ptr = root.load(memory_order_acquire);
+		while (ptr != NULL) {
+			if (key == ptr->info)
+				return true;
+			uintptr_t word = key < ptr->info ? ptr->left.load(memory_order_acquire) : ptr->right.load(memory_order_acquire);
+			if (isThread(word))
+				return false;
+			ptr = target(word);
+		}
+		return false;
+	}
+
+	// Lock free threaded inorder scan, calls visit(key) for every key in increasing order
+	template <typename Visitor>
+	void scan(Visitor visit) {
+		ReadGuard guard(*this);
+		CNode *ptr = root.load(memory_order_acquire);
+		if (ptr == NULL)
+			return;
+		ptr = leftmost(ptr);
+
+		bool first = true;
+		int last = 0;
+		while (ptr != NULL) {
+			if (first || ptr->info > last) {
+				visit(ptr->info);
+				last = ptr->info;
+				first = false;
+			}
+			ptr = getInorderSuccessor(ptr);
+		}
+	}
+
+	// Returns false for a duplicate key
+	bool insert(int ikey) {
+		lock_guard<mutex> lock(writer);
+		CNode *ptr = root.load(memory_order_relaxed);
+		CNode *par = NULL;
+		while (ptr != NULL) {
+			if (ikey == ptr->info)
+				return false;
+			par = ptr;
+			uintptr_t word = ikey < ptr->info ? ptr->left.load(memory_order_relaxed) : ptr->right.load(memory_order_relaxed);
+			if (isThread(word))
+				break;
+			ptr = target(word);
+		}
+
+		// the new leaf is fully built before a single release store makes it reachable
+		CNode *tmp = new CNode(ikey);
+		if (par == NULL) {
+			root.store(tmp, memory_order_release);
+		} else if (ikey < par->info) {
+			tmp->left.store(par->left.load(memory_order_relaxed), memory_order_relaxed);  // Predecessor
+			tmp->right.store(thread(par), memory_order_relaxed);						   // Successor
+			par->left.store(link(tmp), memory_order_release);
+		} else {
+			tmp->left.store(thread(par), memory_order_relaxed);							   // Predecessor
+			tmp->right.store(par->right.load(memory_order_relaxed), memory_order_relaxed);  // Successor
+			par->right.store(link(tmp), memory_order_release);
+		}
+		return true;
+	}
+
+	// Returns false if the key is not present
+	bool remove(int dkey) {
+		lock_guard<mutex> lock(writer);
+		CNode *ptr = root.load(memory_order_relaxed);
+		CNode *par = NULL;
+		while (ptr != NULL && ptr->info != dkey) {
+			par = ptr;
+			uintptr_t word = dkey < ptr->info ? ptr->left.load(memory_order_relaxed) : ptr->right.load(memory_order_relaxed);
+			if (isThread(word))
+				return false;
+			ptr = target(word);
+		}
+		if (ptr == NULL)
+			return false;
+
+		uintptr_t lword = ptr->left.load(memory_order_relaxed);
+		uintptr_t rword = ptr->right.load(memory_order_relaxed);
+
+		if (isThread(lword) && isThread(rword)) {  // No children, the parent inherits ptr's thread
+			if (par != NULL && par->left.load(memory_order_relaxed) == link(ptr))
+				par->left.store(lword, memory_order_release);
+			else if (par != NULL)
+				par->right.store(rword, memory_order_release);
+			else
+				root.store(NULL, memory_order_release);
+		} else if (isThread(lword) || isThread(rword)) {  // One child, redirect the thread that pointed at ptr first
+			CNode *s = getInorderSuccessor(ptr);
+			CNode *p = getInorderPredecessor(ptr);
+			if (!isThread(lword))
+				p->right.store(thread(s), memory_order_release);
+			else
+				s->left.store(thread(p), memory_order_release);
+			replaceChild(par, ptr, isThread(lword) ? rword : lword);
+		} else {  // Two children, swap in a copy of the successor instead of overwriting ptr->info
+			CNode *parsucc = ptr;
+			CNode *succ = target(rword);
+			for (uintptr_t word = succ->left.load(memory_order_relaxed); !isThread(word); word = succ->left.load(memory_order_relaxed)) {
+				parsucc = succ;
+				succ = target(word);
+			}
+			CNode *pred = rightmost(target(lword));
+			uintptr_t sword = succ->right.load(memory_order_relaxed);
+
+			CNode *tmp = new CNode(succ->info);
+			tmp->left.store(lword, memory_order_relaxed);
+			tmp->right.store(parsucc == ptr ? sword : rword, memory_order_relaxed);
+
+			// publish the copy, until succ is unlinked below a scan may meet its key twice
+			replaceChild(par, ptr, link(tmp));
+			pred->right.store(thread(tmp), memory_order_release);
+			if (parsucc != ptr) {
+				// a reader still on ptr reaches succ only through ptr's right subtree, unlinking succ now
+				// would make it skip a key that never left the tree, so wait until all of them are gone
+				synchronize();
+				parsucc->left.store(isThread(sword) ? thread(tmp) : sword, memory_order_release);
+			}
+			if (!isThread(sword))  // the first node of succ's right subtree now follows tmp
+				leftmost(target(sword))->left.store(thread(tmp), memory_order_release);
+			retire(succ);
+		}
+		retire(ptr);
+		return true;
+	}
+};
+
+}  // namespace tbt
@@ -0,0 +1,106 @@
+/*
+XOR linked list, see 2-XORlist.cpp for how it works.
+https://adi22maurya.medium.com/xor-linked-list-7c540e08d986
+
+Everything lives in namespace xorlist so that it can be included next to the other containers,
+which define a Node class of their own (5-BulkIO.cpp includes all of them).
+*/
+
+#pragma once
+
+#include <cinttypes>
+#include <iostream>
+
+#include "MemoryStats.h"
+
+namespace xorlist {
+
+using namespace std;
+
+// every node is allocated through the allocator hook and counted in Node::memoryStats(),
+// one allocation per element so memoryStats().liveAllocations() is the number of elements
+class Node : public Tracked<Node> {
+public:
+	int data;
+	Node* xnode;
+};
+
+/*
+reinterpret_cast :-
+It is used to convert a pointer of some data type into a pointer of another data type,
+   int* p = new int(65);
+   char* ch = reinterpret_cast<char*>(p);  // here ch = A, as p casted to char pointer and assigned to ch pointer.
+*/
+
+inline Node* Xor(Node* x, Node* y) {
+	return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(x) ^ reinterpret_cast<uintptr_t>(y));
+}
+
+inline void insertFirst(Node** head, int data) {
+	Node* new_node = new Node();
+	new_node->data = data;
+
+	new_node->xnode = *head;
+
+	if (*head != NULL) {
+		(*head)->xnode = Xor(new_node, (*head)->xnode);
+	}
+
+	*head = new_node;
+}
+
+inline void printList(Node* head) {
+	Node* curr = head;
+	Node* prev = NULL;
+	Node* next;
+
+	while (curr != NULL) {
+		cout << curr->data << " ";
+		next = Xor(prev, curr->xnode);
+		prev = curr;
+		curr = next;
+	}
+
+	cout << "\n\n";
+	curr = prev;
+	next = NULL;
+	while (curr != NULL) {
+		cout << curr->data << " ";
+		prev = Xor(next, curr->xnode);
+		next = curr;
+		curr = prev;
+	}
+}
+
+// Frees every node of the list, walking forward while the previous node is still known
+inline void freeList(Node** head) {
+	Node* curr = *head;
+	Node* prev = NULL;
+	Node* next;
+
+	while (curr != NULL) {
+		next = Xor(prev, curr->xnode);
+		prev = curr;
+		delete curr;
+		curr = next;
+	}
+	*head = NULL;
+}
+
+// Calls visit(data) for every node starting at head, the list can be walked from either end
+// so passing the last node as head visits the list backwards
+template <typename Visitor>
+void forEach(Node* head, Visitor visit) {
+	Node* curr = head;
+	Node* prev = NULL;
+	Node* next;
+
+	while (curr != NULL) {
+		visit(curr->data);
+		next = Xor(prev, curr->xnode);
+		prev = curr;
+		curr = next;
+	}
+}
+
+}  // namespace xorlist